@@ -0,0 +1,168 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of htmlify.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef HTMLIFY_BBCODECHECKER_HPP
+#define HTMLIFY_BBCODECHECKER_HPP
+
+#include <cstring>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* struct TagIssue:
+      a problem found by the BBCodeChecker
+*/
+struct TagIssue
+{
+  std::string::size_type offset; // byte offset of the tag in the text
+  std::string message;           // description of the problem
+};
+
+/* struct BBCodeChecker:
+      checks whether the BB codes in a text are known and properly nested,
+      without converting the text
+
+      Only text of the form [name], [name=...] or [/name], where name consists
+      of letters only, is considered to be a tag. Everything else, e.g. [1] or
+      [*], is treated as plain text.
+*/
+struct BBCodeChecker
+{
+  public:
+    /* constructor
+
+       parameters:
+           paired - names of codes that need a closing tag, e.g. "b"
+           single - names of codes without closing tag, e.g. "hr"
+    */
+    BBCodeChecker(const std::set<std::string>& paired, const std::set<std::string>& single)
+    : m_Paired(paired), m_Single(single)
+    { }
+
+    /* checks the given text in a single pass
+
+       parameters:
+           text - the BB code text
+
+       return value:
+           Returns the found issues, ordered by offset of detection.
+           Returns an empty vector, if the text is well formed.
+    */
+    std::vector<TagIssue> check(const std::string& text) const
+    {
+      std::vector<TagIssue> issues;
+      // open tags: name and offset
+      std::vector<std::pair<std::string, std::string::size_type> > open;
+      const char * const begin = text.data();
+      const char * const end = begin + text.size();
+      const char * current = begin;
+      // position of the next ']' for tags with attribute, or end if there is
+      // none; it is only searched again after the scan has passed it, so
+      // that the text is searched for ']' just once
+      const char * nextClose = nullptr;
+      while (current < end)
+      {
+        const char * bracket = static_cast<const char*>(std::memchr(current, '[', end - current));
+        if (bracket == nullptr)
+          break;
+        const std::string::size_type offset = bracket - begin;
+        current = bracket + 1;
+
+        const bool closing = (current < end) && (*current == '/');
+        const char * name_begin = closing ? current + 1 : current;
+        const char * name_end = name_begin;
+        while ((name_end < end) && isAsciiLetter(*name_end))
+          ++name_end;
+        if ((name_end == name_begin) || (name_end == end))
+          continue;
+        if ((*name_end != ']') && (closing || (*name_end != '=')))
+          continue;
+        if (*name_end == '=')
+        {
+          if ((nextClose == nullptr) || (nextClose < name_end))
+          {
+            const char * found = static_cast<const char*>(std::memchr(name_end, ']', end - name_end));
+            nextClose = (found != nullptr) ? found : end;
+          }
+          if (nextClose == end)
+            continue;
+        }
+
+        std::string name(name_begin, name_end);
+        for (char& c: name)
+        {
+          if ((c >= 'A') && (c <= 'Z'))
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        current = name_end;
+
+        if (m_Single.find(name) != m_Single.end())
+        {
+          if (closing)
+            issues.push_back({ offset, "[/" + name + "] is not allowed, [" + name + "] has no closing tag" });
+          continue;
+        }
+        if (m_Paired.find(name) == m_Paired.end())
+        {
+          issues.push_back({ offset, std::string("unknown tag [") + (closing ? "/" : "") + name + "]" });
+          continue;
+        }
+        if (!closing)
+        {
+          open.emplace_back(name, offset);
+          continue;
+        }
+
+        // closing tag: find the matching open tag
+        std::vector<std::pair<std::string, std::string::size_type> >::size_type idx = open.size();
+        while ((idx > 0) && (open[idx - 1].first != name))
+          --idx;
+        if (idx == 0)
+        {
+          issues.push_back({ offset, "[/" + name + "] has no matching [" + name + "]" });
+          continue;
+        }
+        for (auto pos = open.size(); pos > idx; --pos)
+        {
+          issues.push_back({ open[pos - 1].second, "[" + open[pos - 1].first
+                             + "] is not closed before [/" + name + "] at offset "
+                             + std::to_string(offset) });
+        }
+        open.resize(idx - 1);
+      }
+
+      for (const auto& [name, offset]: open)
+      {
+        issues.push_back({ offset, "[" + name + "] is never closed" });
+      }
+      return issues;
+    }
+  private:
+    static bool isAsciiLetter(const char c)
+    {
+      return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'));
+    }
+
+    std::set<std::string> m_Paired; // codes that need a closing tag
+    std::set<std::string> m_Single; // codes without closing tag
+};//struct
+
+#endif // HTMLIFY_BBCODECHECKER_HPP
@@ -0,0 +1,387 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of htmlify.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef HTMLIFY_COMPRESSION_HPP
+#define HTMLIFY_COMPRESSION_HPP
+
+#include <ostream>
+#include <string>
+#ifndef NO_GZIP
+#include <zlib.h>
+#endif
+#ifndef NO_ZSTD
+#include <zstd.h>
+#endif
+#include "../pmdb/libstriezel/common/StringUtils.hpp"
+
+/* enumeration type for the supported compression methods */
+enum class Compression
+{
+  none,
+  gzip,
+  zstd
+};
+
+/* struct CompressionSettings:
+      holds the compression method and level for output files
+*/
+struct CompressionSettings
+{
+  Compression method = Compression::none;
+  int level = 0;
+};
+
+// size of the intermediate buffers used for (de-)compression
+const std::string::size_type compressionChunkSize = 16 * 1024;
+
+/* checks whether the given compression method is available in this build
+
+   parameters:
+       method - the compression method
+*/
+bool isAvailable(const Compression method)
+{
+  switch (method)
+  {
+    case Compression::gzip:
+      #ifndef NO_GZIP
+      return true;
+      #else
+      return false;
+      #endif
+    case Compression::zstd:
+      #ifndef NO_ZSTD
+      return true;
+      #else
+      return false;
+      #endif
+    case Compression::none:
+    default:
+      return true;
+  }
+}
+
+/* returns the human-readable name of the compression method
+
+   parameters:
+       method - the compression method
+*/
+std::string toString(const Compression method)
+{
+  switch (method)
+  {
+    case Compression::gzip:
+      return "gzip";
+    case Compression::zstd:
+      return "zstd";
+    case Compression::none:
+    default:
+      return "none";
+  }
+}
+
+/* returns the file name suffix for files compressed with the given method
+
+   parameters:
+       method - the compression method
+*/
+std::string fileSuffix(const Compression method)
+{
+  switch (method)
+  {
+    case Compression::gzip:
+      return ".gz";
+    case Compression::zstd:
+      return ".zst";
+    case Compression::none:
+    default:
+      return "";
+  }
+}
+
+/* parses a compression specification of the form "METHOD" or "METHOD:LEVEL",
+   e.g. "gzip" or "zstd:19"
+
+   parameters:
+       spec     - the specification string
+       settings - receives the parsed settings
+
+   return value:
+       Returns true, if the specification is valid.
+       Returns false otherwise. settings will be unchanged in that case.
+*/
+bool parseCompression(const std::string& spec, CompressionSettings& settings)
+{
+  const std::string::size_type colon = spec.find(':');
+  const std::string name = spec.substr(0, colon);
+  CompressionSettings result;
+  const int minLevel = 1;
+  int maxLevel = 1;
+  if (name == "gzip")
+  {
+    result.method = Compression::gzip;
+    result.level = 6;
+    maxLevel = 9;
+  }
+  else if (name == "zstd")
+  {
+    result.method = Compression::zstd;
+    result.level = 3;
+    maxLevel = 19;
+  }
+  else
+    return false;
+
+  if (colon != std::string::npos)
+  {
+    unsigned int level = 0;
+    if (!stringToUnsignedInt(spec.substr(colon + 1), level))
+      return false;
+    if ((level < static_cast<unsigned int>(minLevel))
+        || (level > static_cast<unsigned int>(maxLevel)))
+      return false;
+    result.level = static_cast<int>(level);
+  }
+  settings = result;
+  return true;
+}
+
+/* detects the compression method of data by looking at its magic bytes
+
+   parameters:
+       data - the (possibly compressed) data
+
+   return value:
+       Returns the detected compression method.
+       Returns Compression::none, if the data is not compressed.
+*/
+Compression detectCompression(const std::string& data)
+{
+  if ((data.size() >= 2) && (data[0] == '\x1F') && (data[1] == '\x8B'))
+    return Compression::gzip;
+  if ((data.size() >= 4) && (data.compare(0, 4, "\x28\xB5\x2F\xFD") == 0))
+    return Compression::zstd;
+  return Compression::none;
+}
+
+/* decompresses data
+
+   parameters:
+       data    - the compressed data
+       method  - the compression method that was used for data
+       result  - receives the decompressed data
+       maxSize - maximum allowed size of the decompressed data in bytes
+
+   return value:
+       Returns true, if the decompression was successful.
+       Returns false otherwise, e.g. if data is corrupt, the decompressed data
+       exceeds maxSize or the method is not available in this build.
+*/
+bool decompress(const std::string& data, const Compression method,
+                std::string& result, const std::string::size_type maxSize)
+{
+  result.clear();
+  switch (method)
+  {
+    case Compression::gzip:
+      {
+        #ifndef NO_GZIP
+        char chunk[compressionChunkSize];
+        z_stream stream{};
+        // 15 + 32: maximum window size and automatic header detection
+        if (inflateInit2(&stream, 15 + 32) != Z_OK)
+          return false;
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = static_cast<uInt>(data.size());
+        int ret = Z_OK;
+        do
+        {
+          stream.next_out = reinterpret_cast<Bytef*>(chunk);
+          stream.avail_out = compressionChunkSize;
+          ret = inflate(&stream, Z_NO_FLUSH);
+          if ((ret != Z_OK) && (ret != Z_STREAM_END))
+          {
+            inflateEnd(&stream);
+            return false;
+          }
+          result.append(chunk, compressionChunkSize - stream.avail_out);
+          if (result.size() > maxSize)
+          {
+            inflateEnd(&stream);
+            return false;
+          }
+          // Files may consist of several concatenated gzip members.
+          if ((ret == Z_STREAM_END) && (stream.avail_in > 0))
+          {
+            if (inflateReset(&stream) != Z_OK)
+            {
+              inflateEnd(&stream);
+              return false;
+            }
+            ret = Z_OK;
+          }
+        } while (ret != Z_STREAM_END);
+        inflateEnd(&stream);
+        return true;
+        #else
+        return false;
+        #endif
+      }
+    case Compression::zstd:
+      {
+        #ifndef NO_ZSTD
+        char chunk[compressionChunkSize];
+        ZSTD_DCtx * context = ZSTD_createDCtx();
+        if (context == nullptr)
+          return false;
+        ZSTD_inBuffer input = { data.data(), data.size(), 0 };
+        std::size_t ret = 0;
+        // A non-zero return value means that the current frame is not
+        // complete yet, i.e. there may still be data left to flush. Once all
+        // input is consumed and the frame is complete, calling the function
+        // again would start a new frame.
+        do
+        {
+          ZSTD_outBuffer output = { chunk, compressionChunkSize, 0 };
+          ret = ZSTD_decompressStream(context, &output, &input);
+          if (ZSTD_isError(ret))
+          {
+            ZSTD_freeDCtx(context);
+            return false;
+          }
+          result.append(chunk, output.pos);
+          if (result.size() > maxSize)
+          {
+            ZSTD_freeDCtx(context);
+            return false;
+          }
+          // Without any progress the frame is truncated.
+          if ((output.pos == 0) && (input.pos == input.size) && (ret != 0))
+            break;
+        } while ((ret != 0) || (input.pos < input.size));
+        ZSTD_freeDCtx(context);
+        // A non-zero value indicates a truncated frame.
+        return ret == 0;
+        #else
+        return false;
+        #endif
+      }
+    case Compression::none:
+    default:
+      if (data.size() > maxSize)
+        return false;
+      result = data;
+      return true;
+  }
+}
+
+/* compresses data and writes the compressed data to a stream, chunk by chunk
+
+   parameters:
+       output   - the output stream, should be opened in binary mode
+       data     - the data that shall be compressed
+       settings - compression method and level
+
+   return value:
+       Returns true, if the compressed data was written successfully.
+       Returns false otherwise.
+*/
+bool writeCompressed(std::ostream& output, const std::string& data,
+                     const CompressionSettings& settings)
+{
+  switch (settings.method)
+  {
+    case Compression::gzip:
+      {
+        #ifndef NO_GZIP
+        char chunk[compressionChunkSize];
+        z_stream stream{};
+        // 15 + 16: maximum window size and gzip header instead of zlib header
+        if (deflateInit2(&stream, settings.level, Z_DEFLATED, 15 + 16, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+          return false;
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = static_cast<uInt>(data.size());
+        int ret = Z_OK;
+        do
+        {
+          stream.next_out = reinterpret_cast<Bytef*>(chunk);
+          stream.avail_out = compressionChunkSize;
+          ret = deflate(&stream, Z_FINISH);
+          if (ret == Z_STREAM_ERROR)
+          {
+            deflateEnd(&stream);
+            return false;
+          }
+          output.write(chunk, compressionChunkSize - stream.avail_out);
+          if (!output.good())
+          {
+            deflateEnd(&stream);
+            return false;
+          }
+        } while (ret != Z_STREAM_END);
+        deflateEnd(&stream);
+        return true;
+        #else
+        return false;
+        #endif
+      }
+    case Compression::zstd:
+      {
+        #ifndef NO_ZSTD
+        char chunk[compressionChunkSize];
+        ZSTD_CCtx * context = ZSTD_createCCtx();
+        if (context == nullptr)
+          return false;
+        ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, settings.level);
+        ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+        ZSTD_CCtx_setPledgedSrcSize(context, data.size());
+        ZSTD_inBuffer input = { data.data(), data.size(), 0 };
+        std::size_t remaining = 0;
+        do
+        {
+          ZSTD_outBuffer out = { chunk, compressionChunkSize, 0 };
+          remaining = ZSTD_compressStream2(context, &out, &input, ZSTD_e_end);
+          if (ZSTD_isError(remaining))
+          {
+            ZSTD_freeCCtx(context);
+            return false;
+          }
+          output.write(chunk, out.pos);
+          if (!output.good())
+          {
+            ZSTD_freeCCtx(context);
+            return false;
+          }
+        } while (remaining != 0);
+        ZSTD_freeCCtx(context);
+        return true;
+        #else
+        return false;
+        #endif
+      }
+    case Compression::none:
+    default:
+      output.write(data.c_str(), data.length());
+      return output.good();
+  }
+}
+
+#endif // HTMLIFY_COMPRESSION_HPP
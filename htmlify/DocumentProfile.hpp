@@ -0,0 +1,120 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of htmlify.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef HTMLIFY_DOCUMENTPROFILE_HPP
+#define HTMLIFY_DOCUMENTPROFILE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <set>
+#include <string>
+
+/* struct DocumentProfile:
+      records which kinds of characters and which tag names occur in a text,
+      so that processing steps that cannot change the text can be skipped
+*/
+struct DocumentProfile
+{
+  bool hasNonAscii = false;       // any byte >= 0x80
+  bool hasCarriageReturn = false; // any '\r'
+  bool hasNewline = false;        // any '\n'
+  bool hasDoubleSpace = false;    // two consecutive spaces
+  bool hasLessThan = false;       // any '<', i.e. possibly literal HTML
+  std::set<std::string> tags;     // lower-case names following '[' or "[/"
+
+  /* checks whether a tag name occurs in the text
+
+     parameters:
+         name - lower-case tag name, e.g. "table"
+  */
+  bool hasTag(const std::string& name) const
+  {
+    return tags.find(name) != tags.end();
+  }
+};//struct
+
+/* scans a text once and returns its profile
+
+   parameters:
+       text - the text to scan
+*/
+DocumentProfile scanDocument(const std::string& text)
+{
+  DocumentProfile profile;
+  const unsigned char * data = reinterpret_cast<const unsigned char*>(text.data());
+  const std::size_t size = text.size();
+  if (size == 0)
+    return profile;
+
+  // The flags are accumulated without branches, so that the compiler can
+  // vectorize the loop.
+  unsigned char high = data[0] & 0x80;
+  unsigned char cr = (data[0] == '\r');
+  unsigned char lf = (data[0] == '\n');
+  unsigned char lt = (data[0] == '<');
+  unsigned char bracket = (data[0] == '[');
+  unsigned char doubleSpace = 0;
+  for (std::size_t i = 1; i < size; ++i)
+  {
+    const unsigned char c = data[i];
+    high |= c & 0x80;
+    cr |= (c == '\r');
+    lf |= (c == '\n');
+    lt |= (c == '<');
+    bracket |= (c == '[');
+    doubleSpace |= (c == ' ') & (data[i - 1] == ' ');
+  }
+  profile.hasNonAscii = (high != 0);
+  profile.hasCarriageReturn = (cr != 0);
+  profile.hasNewline = (lf != 0);
+  profile.hasLessThan = (lt != 0);
+  profile.hasDoubleSpace = (doubleSpace != 0);
+  if (bracket == 0)
+    return profile;
+
+  const char * const end = text.data() + size;
+  const char * current = text.data();
+  while (current < end)
+  {
+    const char * found = static_cast<const char*>(std::memchr(current, '[', end - current));
+    if (found == nullptr)
+      break;
+    current = found + 1;
+    if ((current < end) && (*current == '/'))
+      ++current;
+    std::string name;
+    while (current < end)
+    {
+      const char c = *current;
+      if ((c >= 'a') && (c <= 'z'))
+        name.push_back(c);
+      else if ((c >= 'A') && (c <= 'Z'))
+        name.push_back(static_cast<char>(c - 'A' + 'a'));
+      else
+        break;
+      ++current;
+    }
+    if (!name.empty())
+      profile.tags.insert(name);
+  }
+  return profile;
+}
+
+#endif // HTMLIFY_DOCUMENTPROFILE_HPP
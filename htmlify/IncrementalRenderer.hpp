@@ -0,0 +1,345 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of htmlify.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef HTMLIFY_INCREMENTALRENDERER_HPP
+#define HTMLIFY_INCREMENTALRENDERER_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+/* struct TextEdit:
+      a change of a text: removed characters are replaced by inserted text
+*/
+struct TextEdit
+{
+  std::string::size_type offset = 0;  // position of the change in the text
+  std::string::size_type removed = 0; // number of removed characters
+  std::string inserted;               // text that is inserted at offset
+};
+
+/* struct IncrementalRenderer:
+      keeps the converted form of a text as a sequence of top-level blocks,
+      so that an edit only needs the affected blocks to be converted again
+
+      A block ends after two or more line breaks that are not inside of an
+      open tag. The converter has to turn a text into the concatenation of
+      the conversions of its blocks, which holds for the BB code parser as long
+      as no code spans a block boundary - and that is what the splitting
+      ensures. Closing tags that do not match the innermost open tag are
+      ignored, so malformed input results in larger blocks, never in a split
+      within a code.
+*/
+struct IncrementalRenderer
+{
+  public:
+    // function that converts BB code text to (X)HTML
+    typedef std::function<std::string(const std::string&)> Converter;
+
+    /* constructor
+
+       parameters:
+           convert - function that converts text
+           paired  - lower-case names of the codes that need a closing tag
+    */
+    IncrementalRenderer(const Converter& convert, const std::set<std::string>& paired)
+    : m_Convert(convert), m_Paired(paired), m_Text(), m_Blocks()
+    { }
+
+    /* converts a complete text, discarding any previous state
+
+       parameters:
+           text - the new text
+    */
+    void render(const std::string& text)
+    {
+      m_Blocks.clear();
+      m_Text = text;
+      std::vector<std::string> open;
+      std::vector<std::string::size_type> ends;
+      scan(text, 0, open, ends);
+      ends.push_back(text.size());
+      std::string::size_type begin = 0;
+      for (const auto end: ends)
+      {
+        Block block;
+        block.length = end - begin;
+        block.output = m_Convert(text.substr(begin, block.length));
+        m_Blocks.push_back(std::move(block));
+        begin = end;
+      }
+    }
+
+    /* applies an edit to the text and converts the affected blocks again
+
+       parameters:
+           edit   - the edit
+           change - receives the change of the output: offset is the position
+                    in the previous output, removed the number of characters
+                    that were replaced by inserted
+
+       return value:
+           Returns true, if the edit was applied.
+           Returns false, if the edit is outside of the text.
+    */
+    bool applyEdit(const TextEdit& edit, TextEdit& change)
+    {
+      if ((edit.offset > m_Text.size()) || (edit.removed > m_Text.size() - edit.offset))
+        return false;
+      if (m_Blocks.empty())
+      {
+        render(edit.inserted);
+        change.offset = 0;
+        change.removed = 0;
+        change.inserted = output();
+        return true;
+      }
+
+      // The region starts with the block that holds the character before the
+      // edit, because the edit may extend its trailing line breaks. It ends
+      // with the block that holds the character after the edit.
+      const auto first = findBlock((edit.offset > 0) ? edit.offset - 1 : 0);
+      auto last = findBlock(edit.offset + edit.removed);
+      std::string::size_type regionBegin = 0;
+      std::string::size_type outputBegin = 0;
+      for (std::vector<Block>::size_type idx = 0; idx < first; ++idx)
+      {
+        regionBegin += m_Blocks[idx].length;
+        outputBegin += m_Blocks[idx].output.size();
+      }
+
+      // build the edited text of the region
+      std::string::size_type regionEnd = regionBegin;
+      std::string::size_type oldOutputSize = 0;
+      for (auto idx = first; idx <= last; ++idx)
+      {
+        regionEnd += m_Blocks[idx].length;
+        oldOutputSize += m_Blocks[idx].output.size();
+      }
+      std::string region = m_Text.substr(regionBegin, regionEnd - regionBegin);
+      region.replace(edit.offset - regionBegin, edit.removed, edit.inserted);
+
+      // Extend the region until its end is a block boundary again, e.g. when
+      // the edit opened a tag that is closed in a later block. The scan
+      // continues where it stopped, so that each block is scanned only once.
+      std::vector<std::string> open;
+      std::vector<std::string::size_type> ends;
+      std::string::size_type scanned = 0;
+      while (!scan(region, scanned, open, ends) && (last + 1 < m_Blocks.size()))
+      {
+        scanned = region.size();
+        ++last;
+        region.append(m_Text, regionEnd, m_Blocks[last].length);
+        regionEnd += m_Blocks[last].length;
+        oldOutputSize += m_Blocks[last].output.size();
+      }
+      ends.push_back(region.size());
+
+      std::vector<Block> blocks;
+      change.inserted.clear();
+      std::string::size_type begin = 0;
+      for (const auto end: ends)
+      {
+        Block block;
+        block.length = end - begin;
+        block.output = m_Convert(region.substr(begin, block.length));
+        change.inserted += block.output;
+        blocks.push_back(std::move(block));
+        begin = end;
+      }
+      change.offset = outputBegin;
+      change.removed = oldOutputSize;
+
+      m_Blocks.erase(m_Blocks.begin() + first, m_Blocks.begin() + last + 1);
+      m_Blocks.insert(m_Blocks.begin() + first, std::make_move_iterator(blocks.begin()),
+                      std::make_move_iterator(blocks.end()));
+      m_Text.replace(regionBegin, regionEnd - regionBegin, region);
+      return true;
+    }
+
+    /* replaces the text with a new version; the edit is determined from the
+       common beginning and end of both versions
+
+       parameters:
+           text   - the new version of the text
+           change - receives the change of the output, see applyEdit()
+    */
+    void update(const std::string& text, TextEdit& change)
+    {
+      const std::string::size_type maxCommon = std::min(m_Text.size(), text.size());
+      const std::string::size_type prefix = std::mismatch(m_Text.begin(), m_Text.begin() + maxCommon,
+                                                          text.begin()).first - m_Text.begin();
+      const std::string::size_type suffix = std::mismatch(m_Text.rbegin(), m_Text.rbegin() + (maxCommon - prefix),
+                                                          text.rbegin()).first - m_Text.rbegin();
+
+      TextEdit edit;
+      edit.offset = prefix;
+      edit.removed = m_Text.size() - prefix - suffix;
+      edit.inserted = text.substr(prefix, text.size() - prefix - suffix);
+      applyEdit(edit, change);
+    }
+
+    /* returns the current text */
+    const std::string& text() const
+    {
+      return m_Text;
+    }
+
+    /* returns the converted form of the current text */
+    std::string output() const
+    {
+      std::string result;
+      for (const auto& block: m_Blocks)
+        result += block.output;
+      return result;
+    }
+  private:
+    struct Block
+    {
+      std::string::size_type length; // length of the block's BB code text
+      std::string output;            // converted text of the block
+    };
+
+    /* returns the index of the block that holds the character at the given
+       position, or the index of the last block, if the position is at or
+       after the end of the text
+
+       parameters:
+           pos - position in the text
+    */
+    std::vector<Block>::size_type findBlock(const std::string::size_type pos) const
+    {
+      std::string::size_type blockEnd = 0;
+      for (std::vector<Block>::size_type idx = 0; idx < m_Blocks.size(); ++idx)
+      {
+        blockEnd += m_Blocks[idx].length;
+        if (pos < blockEnd)
+          return idx;
+      }
+      return m_Blocks.size() - 1;
+    }
+
+    /* finds the block boundaries in a text from a given position on; the
+       scan can be continued after more text has been appended
+
+       parameters:
+           text  - the text
+           begin - position where the scan starts, i.e. the end of the
+                   previous scan or the start of the text
+           open  - names of the tags that are open at begin, innermost last;
+                   receives the tags that are open at the end of the text
+           ends  - the end positions of the found blocks are appended to it,
+                   except for the end of the text
+
+       return value:
+           Returns true, if the text ends with a block boundary.
+           Returns false otherwise.
+    */
+    bool scan(const std::string& text, const std::string::size_type begin,
+              std::vector<std::string>& open, std::vector<std::string::size_type>& ends) const
+    {
+      bool atBoundary = false;
+      const std::string::size_type end = text.size();
+      std::string::size_type i = begin;
+      while (i < end)
+      {
+        const char c = text[i];
+        atBoundary = false;
+        if (c == '[')
+        {
+          i = scanTag(text, i + 1, end, open);
+          continue;
+        }
+        if (((c == '\n') || (c == '\r')) && open.empty())
+        {
+          std::string::size_type breaks = 0;
+          while ((i < end) && ((text[i] == '\n') || (text[i] == '\r')))
+          {
+            if (text[i] == '\n')
+              ++breaks;
+            ++i;
+          }
+          if (breaks >= 2)
+          {
+            atBoundary = true;
+            if (i < end)
+              ends.push_back(i);
+          }
+          continue;
+        }
+        ++i;
+      }
+      return atBoundary;
+    }
+
+    /* reads a tag name after '[' and updates the list of open tags
+
+       parameters:
+           text - the text
+           pos  - position after '['
+           end  - end of the scanned part
+           open - names of the open tags, innermost last
+
+       return value:
+           Returns the position where scanning continues.
+    */
+    std::string::size_type scanTag(const std::string& text, std::string::size_type pos,
+                                   const std::string::size_type end,
+                                   std::vector<std::string>& open) const
+    {
+      const bool closing = (pos < end) && (text[pos] == '/');
+      if (closing)
+        ++pos;
+      std::string name;
+      while (pos < end)
+      {
+        const char c = text[pos];
+        if ((c >= 'a') && (c <= 'z'))
+          name.push_back(c);
+        else if ((c >= 'A') && (c <= 'Z'))
+          name.push_back(static_cast<char>(c - 'A' + 'a'));
+        else
+          break;
+        ++pos;
+      }
+      if (name.empty() || (pos >= end) || (m_Paired.find(name) == m_Paired.end()))
+        return pos;
+      if (closing)
+      {
+        if ((text[pos] == ']') && !open.empty() && (open.back() == name))
+          open.pop_back();
+      }
+      else if ((text[pos] == ']') || (text[pos] == '='))
+      {
+        open.push_back(name);
+      }
+      return pos;
+    }
+
+    Converter m_Convert;
+    std::set<std::string> m_Paired;
+    std::string m_Text;
+    std::vector<Block> m_Blocks;
+};//struct
+
+#endif // HTMLIFY_INCREMENTALRENDERER_HPP
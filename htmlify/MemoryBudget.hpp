@@ -0,0 +1,201 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of htmlify.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef HTMLIFY_MEMORYBUDGET_HPP
+#define HTMLIFY_MEMORYBUDGET_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../pmdb/libstriezel/common/StringUtils.hpp"
+
+/* struct MemoryBudget:
+      estimates the working set that is needed to convert a file of a given
+      size and decides whether that fits into a memory limit
+
+      The conversion holds the input text plus several expanded copies of it
+      (special characters, parser, post-processors), so the estimate is
+      input size * (1 + 3 * expansion), where expansion is the largest ratio
+      of output size to input size seen so far.
+*/
+struct MemoryBudget
+{
+  public:
+    /* constructor
+
+       parameters:
+           limit - the memory limit in bytes
+    */
+    explicit MemoryBudget(const std::uint64_t limit)
+    : m_Limit(limit), m_Expansion(2.0)
+    { }
+
+    /* returns the memory limit in bytes */
+    std::uint64_t limit() const
+    {
+      return m_Limit;
+    }
+
+    /* returns the estimated working set for converting an input of the given
+       size in bytes
+
+       parameters:
+           inputSize - size of the (uncompressed) input in bytes
+    */
+    std::uint64_t estimate(const std::uint64_t inputSize) const
+    {
+      const double estimated = static_cast<double>(inputSize) * (1.0 + 3.0 * m_Expansion);
+      if (estimated >= static_cast<double>(UINT64_MAX))
+        return UINT64_MAX;
+      return static_cast<std::uint64_t>(estimated);
+    }
+
+    /* checks whether an input of the given size fits into the limit
+
+       parameters:
+           inputSize - size of the (uncompressed) input in bytes
+    */
+    bool admits(const std::uint64_t inputSize) const
+    {
+      return estimate(inputSize) <= m_Limit;
+    }
+
+    /* records the sizes of a finished conversion to refine later estimates
+
+       parameters:
+           inputSize  - size of the (uncompressed) input in bytes
+           outputSize - size of the generated output in bytes
+    */
+    void record(const std::uint64_t inputSize, const std::uint64_t outputSize)
+    {
+      if (inputSize == 0)
+        return;
+      const double ratio = static_cast<double>(outputSize) / static_cast<double>(inputSize);
+      m_Expansion = std::max(m_Expansion, ratio);
+    }
+  private:
+    std::uint64_t m_Limit; // memory limit in bytes
+    double m_Expansion;    // largest observed ratio of output to input size
+};//struct
+
+/* parses a memory size like "512K", "64M" or "2G" (binary units); a number
+   without suffix is interpreted as bytes
+
+   parameters:
+       text  - the text to parse
+       bytes - receives the size in bytes
+
+   return value:
+       Returns true, if the text is a valid, non-zero size.
+       Returns false otherwise.
+*/
+bool parseMemorySize(std::string text, std::uint64_t& bytes)
+{
+  if (text.empty())
+    return false;
+  std::uint64_t factor = 1;
+  switch (text.back())
+  {
+    case 'k':
+    case 'K':
+      factor = 1024;
+      break;
+    case 'm':
+    case 'M':
+      factor = 1024 * 1024;
+      break;
+    case 'g':
+    case 'G':
+      factor = 1024 * 1024 * 1024;
+      break;
+    default:
+      break;
+  }
+  if (factor != 1)
+    text.pop_back();
+  unsigned int value = 0;
+  if (!stringToUnsignedInt(text, value) || (value == 0))
+    return false;
+  bytes = static_cast<std::uint64_t>(value) * factor;
+  return true;
+}
+
+/* determines the size of a file in bytes
+
+   parameters:
+       path - path of the file
+       size - receives the file size
+
+   return value:
+       Returns true, if the size could be determined.
+       Returns false otherwise.
+*/
+bool getFileSize(const std::string& path, std::uint64_t& size)
+{
+  std::ifstream input;
+  input.open(path, std::ios_base::in | std::ios_base::binary);
+  if (!input)
+    return false;
+  input.seekg(0, std::ios_base::end);
+  const std::streamsize len = input.tellg();
+  if (!input.good() || (len < 0))
+    return false;
+  size = static_cast<std::uint64_t>(len);
+  return true;
+}
+
+/* sorts files by size in descending order, so that the largest files - the
+   ones that decide whether the limit holds - are handled first
+
+   parameters:
+       paths  - the files to sort
+       order  - receives pairs of file path and file size, largest file first
+       failed - receives the path of the file whose size could not be
+                determined, if any
+
+   return value:
+       Returns true, if all file sizes could be determined.
+       Returns false otherwise.
+*/
+bool largestFirst(const std::set<std::string>& paths,
+                  std::vector<std::pair<std::string, std::uint64_t> >& order,
+                  std::string& failed)
+{
+  order.clear();
+  for (const auto& path: paths)
+  {
+    std::uint64_t size = 0;
+    if (!getFileSize(path, size))
+    {
+      failed = path;
+      return false;
+    }
+    order.emplace_back(path, size);
+  }
+  std::stable_sort(order.begin(), order.end(),
+      [](const auto& a, const auto& b) { return a.second > b.second; });
+  return true;
+}
+
+#endif // HTMLIFY_MEMORYBUDGET_HPP
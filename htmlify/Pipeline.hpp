@@ -0,0 +1,159 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of htmlify.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef HTMLIFY_PIPELINE_HPP
+#define HTMLIFY_PIPELINE_HPP
+
+#include <set>
+#include <string>
+#include <vector>
+#include "../pmdb/code/bbcode/BBCode.hpp"
+#include "../pmdb/code/bbcode/BBCodeParser.hpp"
+#include "../pmdb/code/bbcode/TextProcessor.hpp"
+#include "DocumentProfile.hpp"
+
+/* struct Pipeline:
+      holds all BB codes and text processors of a conversion together with
+      the conditions under which they can change a text, and sets up a
+      parser with only those parts that a certain document needs
+*/
+struct Pipeline
+{
+  public:
+    // condition that tells whether a processor is needed for a document
+    typedef bool (*Condition)(const DocumentProfile& profile);
+
+    /* enumeration type that tells whether a tag needs a closing tag */
+    enum class TagKind
+    {
+      paired, // e.g. [b]...[/b]
+      single  // e.g. [hr]
+    };
+
+    /* adds a BB code that is only needed when its tag name occurs
+
+       parameters:
+           tag  - lower-case tag name of the code, e.g. "b"
+           code - the BB code, must stay valid as long as the pipeline
+           kind - whether the code needs a closing tag
+    */
+    void addCode(const std::string& tag, BBCode* code, const TagKind kind = TagKind::paired)
+    {
+      m_Codes.push_back({ tag, code, kind });
+    }
+
+    /* adds the name of a tag that needs a closing tag, but has no code of its
+       own, because it is handled by another code, e.g. "tr" within "table"
+
+       parameters:
+           tag - lower-case tag name
+    */
+    void addInnerTag(const std::string& tag)
+    {
+      m_InnerTags.insert(tag);
+    }
+
+    /* returns the lower-case names of all tags of the given kind, including
+       inner tags for TagKind::paired
+
+       parameters:
+           kind - the kind of tags
+    */
+    std::set<std::string> tagNames(const TagKind kind) const
+    {
+      std::set<std::string> names;
+      if (kind == TagKind::paired)
+        names = m_InnerTags;
+      for (const auto& entry: m_Codes)
+      {
+        if (entry.kind == kind)
+          names.insert(entry.tag);
+      }
+      return names;
+    }
+
+    /* adds a pre-processor
+
+       parameters:
+           processor - the processor, must stay valid as long as the pipeline
+           needed    - condition for the processor to be applied
+    */
+    void addPreProcessor(TextProcessor* processor, const Condition needed)
+    {
+      m_PreProcessors.push_back({ processor, needed });
+    }
+
+    /* adds a post-processor
+
+       parameters:
+           processor - the processor, must stay valid as long as the pipeline
+           needed    - condition for the processor to be applied
+    */
+    void addPostProcessor(TextProcessor* processor, const Condition needed)
+    {
+      m_PostProcessors.push_back({ processor, needed });
+    }
+
+    /* adds all codes and processors that the document needs to a parser,
+       keeping their order
+
+       parameters:
+           parser  - a parser without any codes or processors
+           profile - profile of the document
+    */
+    void configure(BBCodeParser& parser, const DocumentProfile& profile) const
+    {
+      for (const auto& entry: m_Codes)
+      {
+        if (profile.hasTag(entry.tag))
+          parser.addCode(entry.code);
+      }
+      for (const auto& entry: m_PreProcessors)
+      {
+        if (entry.needed(profile))
+          parser.addPreProcessor(entry.processor);
+      }
+      for (const auto& entry: m_PostProcessors)
+      {
+        if (entry.needed(profile))
+          parser.addPostProcessor(entry.processor);
+      }
+    }
+  private:
+    struct CodeEntry
+    {
+      std::string tag;
+      BBCode* code;
+      TagKind kind;
+    };
+
+    struct ProcessorEntry
+    {
+      TextProcessor* processor;
+      Condition needed;
+    };
+
+    std::vector<CodeEntry> m_Codes;
+    std::set<std::string> m_InnerTags;
+    std::vector<ProcessorEntry> m_PreProcessors;
+    std::vector<ProcessorEntry> m_PostProcessors;
+};//struct
+
+#endif // HTMLIFY_PIPELINE_HPP
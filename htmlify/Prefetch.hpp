@@ -0,0 +1,75 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of htmlify.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef HTMLIFY_PREFETCH_HPP
+#define HTMLIFY_PREFETCH_HPP
+
+#include <string>
+#if defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// number of files that are read ahead of the file that is being converted
+const unsigned int prefetchDepth = 2;
+
+/* asks the operating system to start reading a file into the page cache in
+   the background, so that a later read of the file does not have to wait for
+   the disk; does nothing on systems without posix_fadvise()
+
+   parameters:
+       path - path of the file
+*/
+void prefetchFile(const std::string& path)
+{
+  #if defined(__unix__) && defined(POSIX_FADV_WILLNEED)
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return;
+  // The read-ahead continues after the file descriptor is closed.
+  posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  close(fd);
+  #else
+  (void) path;
+  #endif
+}
+
+/* asks the operating system to start writing the cached data of a file to
+   the disk in the background without waiting for it, so that dirty pages do
+   not pile up and throttle later writes; does nothing on systems other than
+   Linux
+
+   parameters:
+       path - path of the file
+*/
+void startWriteBack(const std::string& path)
+{
+  #if defined(__linux__) && defined(SYNC_FILE_RANGE_WRITE)
+  const int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd == -1)
+    return;
+  sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+  close(fd);
+  #else
+  (void) path;
+  #endif
+}
+
+#endif // HTMLIFY_PREFETCH_HPP
@@ -0,0 +1,195 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of htmlify.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef HTMLIFY_WATCHMODE_HPP
+#define HTMLIFY_WATCHMODE_HPP
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <string>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// time in milliseconds without new events after which a burst of events is
+// considered to be complete
+const int watchDebounceMilliseconds = 2;
+
+/* checks whether a file name belongs to a file that was generated by htmlify
+   or to a temporary / backup file of an editor, i.e. whether it should not be
+   converted in watch mode
+
+   parameters:
+       name - the file name (without directory)
+*/
+bool isIgnoredInWatchMode(const std::string& name)
+{
+  if (name.empty() || (name[0] == '.') || (name.back() == '~'))
+    return true;
+  for (const std::string suffix: { "_htmlified", "_htmlified.gz", "_htmlified.zst" })
+  {
+    if ((name.length() >= suffix.length())
+        && (name.compare(name.length() - suffix.length(), suffix.length(), suffix) == 0))
+      return true;
+  }
+  return false;
+}
+
+/* adds the names of all regular files in a directory to a set
+
+   parameters:
+       directory - the directory
+       names     - set that receives the file names
+*/
+void listRegularFiles(const std::string& directory, std::set<std::string>& names)
+{
+  DIR * dir = opendir(directory.c_str());
+  if (dir == nullptr)
+    return;
+  const struct dirent * entry = nullptr;
+  while ((entry = readdir(dir)) != nullptr)
+  {
+    struct stat info;
+    const std::string path = directory + "/" + entry->d_name;
+    if ((stat(path.c_str(), &info) == 0) && S_ISREG(info.st_mode))
+      names.insert(entry->d_name);
+  }
+  closedir(dir);
+}
+
+/* reads all pending inotify events from a file descriptor and collects the
+   names of the files that were written
+
+   parameters:
+       fd        - the inotify file descriptor
+       directory - the watched directory
+       names     - set that receives the file names
+
+   return value:
+       Returns true, if the events could be read and the watch is still active.
+       Returns false, if an error occurred or the watched directory is gone.
+*/
+bool readWatchEvents(const int fd, const std::string& directory, std::set<std::string>& names)
+{
+  alignas(struct inotify_event) char buffer[16 * 1024];
+  const ssize_t len = read(fd, buffer, sizeof(buffer));
+  if (len < 0)
+    return (errno == EAGAIN) || (errno == EINTR);
+
+  ssize_t offset = 0;
+  while (offset < len)
+  {
+    const struct inotify_event * event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+    offset += sizeof(struct inotify_event) + event->len;
+    if ((event->mask & IN_IGNORED) != 0)
+      return false;
+    if ((event->mask & IN_Q_OVERFLOW) != 0)
+    {
+      // Events were lost, so every file may have changed.
+      listRegularFiles(directory, names);
+      continue;
+    }
+    if (((event->mask & IN_ISDIR) == 0) && (event->len > 0))
+      names.insert(event->name);
+  }
+  return true;
+}
+
+/* watches a directory for files that are written or moved into it and calls
+   a function for each of those files; only returns when an error occurs
+
+   parameters:
+       directory - the directory to watch
+       convert   - function that converts the file at the given path and
+                   returns zero on success
+
+   return value:
+       Returns false, if the directory cannot be watched (any more).
+*/
+bool watchDirectory(const std::string& directory,
+                    const std::function<int(const std::string&)>& convert)
+{
+  const int fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+  if (fd == -1)
+  {
+    std::cerr << "Error: Could not initialize inotify: " << std::strerror(errno) << "\n";
+    return false;
+  }
+  // IN_CLOSE_WRITE catches files saved in place, IN_MOVED_TO catches editors
+  // that write to a temporary file and rename it afterwards.
+  if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR) == -1)
+  {
+    std::cerr << "Error: Could not watch directory \"" << directory << "\": "
+              << std::strerror(errno) << "\n";
+    close(fd);
+    return false;
+  }
+  std::cout << "Watching directory " << directory << " for changes.\n";
+
+  struct pollfd pfd = { fd, POLLIN, 0 };
+  while (true)
+  {
+    pfd.revents = 0;
+    if (poll(&pfd, 1, -1) < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    // Collect events until there is a short pause, so that a burst of writes
+    // to the same file results in one conversion only.
+    std::set<std::string> changed;
+    bool active = readWatchEvents(fd, directory, changed);
+    while (active && (poll(&pfd, 1, watchDebounceMilliseconds) > 0))
+    {
+      active = readWatchEvents(fd, directory, changed);
+    }
+
+    for (const auto& name: changed)
+    {
+      if (isIgnoredInWatchMode(name))
+        continue;
+      // Temporary files may already be renamed or deleted at this point.
+      const std::string path = directory + "/" + name;
+      struct stat info;
+      if ((stat(path.c_str(), &info) == 0) && S_ISREG(info.st_mode))
+        convert(path);
+    }
+    // Messages have to show up right away, even if output is redirected.
+    std::cout.flush();
+    if (!active)
+      break;
+  }
+  close(fd);
+  std::cerr << "Error: Watching directory \"" << directory << "\" failed!\n";
+  return false;
+}
+
+#endif // __linux__
+
+#endif // HTMLIFY_WATCHMODE_HPP
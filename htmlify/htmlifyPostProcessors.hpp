@@ -48,6 +48,9 @@ struct NormalisingPreProcessor: public TextProcessor
 
 /* struct TablePostProcessor:
       adds my usual indentation to table codes
+
+      Only whitespace next to tags is changed, so it is skipped in compact
+      mode.
 */
 struct TablePostProcessor: public TextProcessor
 {
@@ -126,6 +129,8 @@ struct TablePostProcessor: public TextProcessor
         "\n
          <center>some stuff</center>\n
          "
+
+      Only whitespace is moved, so it is skipped in compact mode.
 */
 struct TDR_PostProcessor: public TextProcessor
 {
@@ -20,8 +20,13 @@
 
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <set>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 #include <cstring>
 #include "../pmdb/libstriezel/filesystem/file.hpp"
 #ifndef NO_STRING_CONVERSION
@@ -37,6 +42,13 @@
 #include "../pmdb/code/bbcode/TableBBCode.hpp"
 #include "../pmdb/code/bbcode/TableClasses.hpp"
 #include "TrimmingBBCodes.hpp"
+#include "BBCodeChecker.hpp"
+#include "Compression.hpp"
+#include "IncrementalRenderer.hpp"
+#include "MemoryBudget.hpp"
+#include "Pipeline.hpp"
+#include "Prefetch.hpp"
+#include "WatchMode.hpp"
 #include "htmlifyPostProcessors.hpp"
 
 // return codes
@@ -45,6 +57,11 @@ const int rcFileError        = 2;
 #ifndef NO_STRING_CONVERSION
 const int rcConversionFail   = 3;
 #endif
+const int rcMemoryLimit      = 4;
+const int rcCheckFailed      = 5;
+
+// maximum size of an input file's (uncompressed) content in bytes
+const std::string::size_type maxInputSize = 1024 * 1024;
 
 void showVersion()
 {
@@ -64,6 +81,9 @@ void showVersion()
 void showHelp(const std::string& name)
 {
   std::cout << "\n" << name << " [--html|--xhtml] FILENAME\n"
+            #if defined(__linux__)
+            << name << " [--html|--xhtml] --watch DIRECTORY\n"
+            #endif
             << '\n'
             << "Converts BB code text input to proper HTML or XHTML snippets.\n"
             << '\n'
@@ -105,7 +125,234 @@ void showHelp(const std::string& name)
             << "                     WIDTH pixels. Larger values will be discarded. Zero will\n"
             << "                     be interpreted as 'no limit'. The default value is 600.\n"
             << "  --no-table-limit - No default max. table width will be set by the program.\n"
-            << "                     Mutually exclusive with --max-table-width=WIDTH.\n";
+            << "                     Mutually exclusive with --max-table-width=WIDTH.\n"
+            << "  --check          - Only checks whether the BB codes in the files are known\n"
+            << "                     and properly nested, without creating any files.\n"
+            << "                     Problems are reported with their byte offsets, and\n"
+            << "                     the exit code is " << rcCheckFailed << ", if any problem was found.\n"
+            << "  --compact        - Skips the purely cosmetic indentation of tables and the\n"
+            << "                     rearrangement of line breaks around <center>. Line\n"
+            << "                     breaks from the code templates are kept, so this does\n"
+            << "                     not remove all whitespace that could be left out. The\n"
+            << "                     output only differs in whitespace at the start and end\n"
+            << "                     of text nodes: both versions have the same DOM after\n"
+            << "                     that whitespace is trimmed and whitespace-only text\n"
+            << "                     nodes are dropped.\n"
+            << "  --compress=METHOD[:LEVEL]\n"
+            << "                   - Compresses the generated files with METHOD, which can\n"
+            << "                     be either gzip or zstd. The generated files get the\n"
+            << "                     additional extension .gz or .zst. LEVEL is the optional\n"
+            << "                     compression level (gzip: 1-9, zstd: 1-19).\n"
+            << "                     Input files that are compressed with gzip or zstd will\n"
+            << "                     always be decompressed automatically.\n"
+            << "  --memory-limit=SIZE\n"
+            << "                   - Sets the memory that may be used for the conversion of\n"
+            << "                     a single file to SIZE bytes. SIZE may have one of the\n"
+            << "                     suffixes K, M or G. Files are then processed largest\n"
+            << "                     first, and the program aborts before any conversion,\n"
+            << "                     if a file's estimated working set exceeds the limit.\n"
+            << "                     Compressed files are checked again when they are\n"
+            << "                     decompressed, which may happen after other files have\n"
+            << "                     already been converted. The exit code is " << rcMemoryLimit << ", if a\n"
+            << "                     file exceeds the limit. The limit of 1 MiB per file\n"
+            << "                     still applies.\n"
+            #if defined(__linux__)
+            << "  --watch DIRECTORY\n"
+            << "                   - Watches DIRECTORY for files that are saved or moved into\n"
+            << "                     it and converts each of those files as soon as it has\n"
+            << "                     been written. Generated files, hidden files and backup\n"
+            << "                     files (ending with '~') are ignored. Files given as\n"
+            << "                     FILENAME are converted before watching starts. The\n"
+            << "                     program keeps running until it is terminated.\n"
+            #endif
+            ;
+}
+
+/* struct ConversionOptions:
+      settings for the conversion of a file that are not part of the parser
+*/
+struct ConversionOptions
+{
+  HTMLStandard standard = HTMLStandard::HTML4_01;
+  bool nl2br = false;
+  #ifndef NO_STRING_CONVERSION
+  bool isUTF8 = false;
+  #endif
+  CompressionSettings compression;
+  MemoryBudget * budget = nullptr;
+};
+
+/* reads the content of a file and decompresses it, if it is compressed
+
+   parameters:
+       path    - path of the input file
+       budget  - memory budget, may be nullptr
+       content - receives the file content
+
+   return value:
+       Returns zero, if the file was read successfully.
+       Returns a non-zero return code otherwise.
+*/
+int readInputFile(const std::string& path, const MemoryBudget * budget, std::string& content)
+{
+  // read file contents
+  std::ifstream input;
+  input.open(path, std::ios_base::in | std::ios_base::binary);
+  if (!input)
+  {
+    std::cerr << "Error: Could not open file \"" << path << "\"!\n";
+    return rcFileError;
+  }
+  input.seekg(0, std::ios_base::end);
+  const std::streamsize len = input.tellg();
+  input.seekg(0, std::ios_base::beg);
+  if (!input.good())
+  {
+    std::cerr << "Error while reading file content of \"" << path << "\": "
+              << "seek operation failed!\n";
+    input.close();
+    return rcFileError;
+  }
+  if (static_cast<std::string::size_type>(len) > maxInputSize)
+  {
+    std::cerr << "Error: File \"" << path << "\" is larger than the maximum "
+              << "of " << maxInputSize << " bytes!\n";
+    input.close();
+    return rcFileError;
+  }
+  // read file content directly into a string - all content should fit in
+  std::string raw(len, '\0');
+  input.read(raw.data(), len);
+  if (!input.good())
+  {
+    input.close();
+    std::cerr << "Error while reading file content of \"" << path << "\"!\n";
+    return rcFileError;
+  }
+  input.close();
+
+  const Compression inputCompression = detectCompression(raw);
+  if (inputCompression == Compression::none)
+  {
+    content = std::move(raw);
+  }
+  else
+  {
+    if (!decompress(raw, inputCompression, content, maxInputSize))
+    {
+      std::cerr << "Error: Could not decompress " << toString(inputCompression)
+                << "-compressed file \"" << path << "\", or its content is "
+                << "larger than " << maxInputSize << " bytes!\n";
+      return rcFileError;
+    }
+    // Compressed files were admitted by their compressed size, their real
+    // size is only known now.
+    if (budget && !budget->admits(content.size()))
+    {
+      std::cerr << "Error: Converting file \"" << path << "\" needs about "
+                << budget->estimate(content.size()) << " bytes of memory after "
+                << "decompression, but the memory limit is " << budget->limit()
+                << " bytes!\n";
+      return rcMemoryLimit;
+    }
+  }
+  // Text ends at the first NUL character, if there is any.
+  const std::string::size_type nul_pos = content.find('\0');
+  if (nul_pos != std::string::npos)
+    content.erase(nul_pos);
+  return 0;
+}
+
+/* converts BB code text to (X)HTML
+
+   parameters:
+       text     - the BB code text
+       pipeline - codes and processors to use for the conversion
+       options  - conversion options
+
+   return value:
+       Returns the converted text.
+*/
+std::string convertText(std::string text, const Pipeline& pipeline, const ConversionOptions& options)
+{
+  // Plain ASCII text has no special characters, and a parser without codes
+  // does not need to look for any tags.
+  const DocumentProfile profile = scanDocument(text);
+  if (profile.hasNonAscii)
+    handleSpecialChars(text);
+  BBCodeParser parser;
+  pipeline.configure(parser, profile);
+  return parser.parse(text, "", options.standard, options.nl2br);
+}
+
+/* converts a single file and writes the result to a file of the same name
+   with the suffix "_htmlified" (plus the suffix of the compression method)
+
+   parameters:
+       path     - path of the input file
+       pipeline - codes and processors to use for the conversion
+       options  - conversion options
+       renderer - renderer that holds the previous version of the file, or
+                  nullptr to convert the whole file
+
+   return value:
+       Returns zero, if the file was converted successfully.
+       Returns a non-zero return code otherwise.
+*/
+int processFile(const std::string& path, const Pipeline& pipeline, const ConversionOptions& options,
+                IncrementalRenderer * renderer = nullptr)
+{
+  std::string content;
+  const int rc = readInputFile(path, options.budget, content);
+  if (rc != 0)
+    return rc;
+
+  #ifndef NO_STRING_CONVERSION
+  if (options.isUTF8)
+  {
+    // convert content to iso-8859-1
+    std::string iso_content;
+    if (!libstriezel::encoding::utf8_to_iso8859_1(content, iso_content))
+    {
+      std::cerr << "Error: Conversion from UTF-8 failed!\n";
+      return rcConversionFail;
+    }
+    content = iso_content;
+  } // if UTF-8
+  #endif
+
+  const std::string::size_type contentSize = content.size();
+  if (renderer != nullptr)
+  {
+    // only the blocks that differ from the previous version are converted
+    TextEdit change;
+    renderer->update(content, change);
+    content = renderer->output();
+  }
+  else
+    content = convertText(content, pipeline, options);
+  if (options.budget)
+    options.budget->record(contentSize, content.size());
+
+  // save content
+  const std::string outputPath = path + "_htmlified" + fileSuffix(options.compression.method);
+  std::ofstream output;
+  output.open(outputPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if (!output)
+  {
+    std::cerr << "Could not open output file " << outputPath << " for writing!\n";
+    return rcFileError;
+  }
+  if (!writeCompressed(output, content, options.compression))
+  {
+    std::cerr << "Error while writing to file \"" << outputPath << "\"!\n";
+    output.close();
+    return rcFileError;
+  }
+  output.close();
+  startWriteBack(outputPath);
+  std::cout << "Processed file " << path << "\n";
+  return 0;
 }
 
 int main(int argc, char* argv[])
@@ -124,6 +371,15 @@ int main(int argc, char* argv[])
   TableClasses tableClasses(true);
   unsigned int tableLimit = 0;
   bool hasSetTableLimit = false;
+  bool compact = false;
+  bool checkOnly = false;
+  CompressionSettings compression;
+  bool hasSetCompression = false;
+  std::unique_ptr<MemoryBudget> budget;
+  std::string watchDirectoryPath;
+  // The output of --check is parsed by other tools, so informational
+  // messages are only shown once it is known that this is no check.
+  std::ostringstream info;
 
   if ((argc > 1) && (argv != nullptr))
   {
@@ -178,8 +434,8 @@ int main(int argc, char* argv[])
             }
             trimmablePrefix = std::string(argv[i+1]);
             ++i; // skip next parameter, because it's used as prefix already
-            std::cout << "Trimmable prefix was set to \"" << trimmablePrefix
-                      << "\".\n";
+            info << "Trimmable prefix was set to \"" << trimmablePrefix
+                 << "\".\n";
           }
           else
           {
@@ -196,8 +452,8 @@ int main(int argc, char* argv[])
             return rcInvalidParameter;
           }
           trimmablePrefix = param.substr(7);
-          std::cout << "Trimmable prefix was set to \"" << trimmablePrefix
-                    << "\".\n";
+          info << "Trimmable prefix was set to \"" << trimmablePrefix
+               << "\".\n";
         }//param == trim (single parameter version)
         else if ((param == "--utf8") || (param == "--UTF-8"))
         {
@@ -287,7 +543,7 @@ int main(int argc, char* argv[])
             tableLimit = arg_val;
             hasSetTableLimit = true;
             ++i; //skip next parameter, because it's used as limit already
-            std::cout << "Table width limit was set to \"" << tableLimit << "\".\n";
+            info << "Table width limit was set to \"" << tableLimit << "\".\n";
           }
           else
           {
@@ -311,7 +567,7 @@ int main(int argc, char* argv[])
           }
           tableLimit = width_val;
           hasSetTableLimit = true;
-          std::cout << "Table width limit was set to \"" << tableLimit << "\".\n";
+          info << "Table width limit was set to \"" << tableLimit << "\".\n";
         }//param == max-table-width (single parameter version)
         else if (param == "--no-table-limit")
         {
@@ -323,8 +579,93 @@ int main(int argc, char* argv[])
           }
           tableLimit = 0;
           hasSetTableLimit = true;
-          std::cout << "No table limit will be set.\n";
+          info << "No table limit will be set.\n";
         }//param == no-table-limit
+        else if (param == "--check")
+        {
+          if (checkOnly)
+          {
+            std::cerr << "Parameter --check must not occur more than once!\n";
+            return rcInvalidParameter;
+          }
+          checkOnly = true;
+        }//param == check
+        else if (param == "--compact")
+        {
+          if (compact)
+          {
+            std::cerr << "Parameter --compact must not occur more than once!\n";
+            return rcInvalidParameter;
+          }
+          compact = true;
+        }//param == compact
+        else if ((param.substr(0,11) == "--compress=") && (param.length() > 11))
+        {
+          if (hasSetCompression)
+          {
+            std::cerr << "Parameter --compress must not occur more than once!\n";
+            return rcInvalidParameter;
+          }
+          if (!parseCompression(param.substr(11), compression))
+          {
+            std::cerr << "Error: \"" << param.substr(11) << "\" is not a valid "
+                      << "compression method! Valid values are gzip, gzip:LEVEL, "
+                      << "zstd and zstd:LEVEL.\n";
+            return rcInvalidParameter;
+          }
+          if (!isAvailable(compression.method))
+          {
+            std::cerr << "Compression method " << toString(compression.method)
+                      << " is not available in this build of htmlify!\n";
+            return rcInvalidParameter;
+          }
+          hasSetCompression = true;
+        }//param == compress
+        else if ((param.substr(0,15) == "--memory-limit=") && (param.length() > 15))
+        {
+          if (budget)
+          {
+            std::cerr << "Parameter --memory-limit must not occur more than once!\n";
+            return rcInvalidParameter;
+          }
+          std::uint64_t limit = 0;
+          if (!parseMemorySize(param.substr(15), limit))
+          {
+            std::cerr << "Error: \"" << param.substr(15) << "\" is not a valid "
+                      << "memory size!\n";
+            return rcInvalidParameter;
+          }
+          budget = std::make_unique<MemoryBudget>(limit);
+          info << "Memory limit was set to " << limit << " bytes.\n";
+        }//param == memory-limit
+        else if ((param == "--watch") || ((param.substr(0,8) == "--watch=") && (param.length() > 8)))
+        {
+          #if defined(__linux__)
+          if (!watchDirectoryPath.empty())
+          {
+            std::cerr << "Parameter --watch must not occur more than once!\n";
+            return rcInvalidParameter;
+          }
+          if (param != "--watch")
+          {
+            watchDirectoryPath = param.substr(8);
+          }
+          else if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            watchDirectoryPath = std::string(argv[i+1]);
+            ++i; // skip next parameter, because it's used as directory already
+          }
+          else
+          {
+            std::cerr << "Error: You have to specify a directory after \""
+                      << param << "\".\n";
+            return rcInvalidParameter;
+          }
+          #else
+          std::cerr << "Parameter --watch is only available on Linux!\n";
+          return rcInvalidParameter;
+          #endif
+        }//param == watch
         else if (libstriezel::filesystem::file::exists(param))
         {
           if (pathTexts.find(param) != pathTexts.end())
@@ -352,13 +693,19 @@ int main(int argc, char* argv[])
   }//if arguments present
 
   // no files to load?
-  if (pathTexts.empty())
+  if (pathTexts.empty() && watchDirectoryPath.empty())
   {
     std::cerr << "You have to specify certain parameters for this programme to run properly.\n"
               << "Use --help to get a list of valid parameters.\n";
     return rcInvalidParameter;
   }
 
+  if (checkOnly && !watchDirectoryPath.empty())
+  {
+    std::cerr << "Parameter --check cannot be combined with --watch!\n";
+    return rcInvalidParameter;
+  }
+
   if (tableClasses.table.empty()) tableClasses.table = TableClasses::DefaultTableClass;
   if (tableClasses.row.empty())   tableClasses.row   = TableClasses::DefaultRowClass;
   if (tableClasses.cell.empty())  tableClasses.cell  = TableClasses::DefaultCellClass;
@@ -367,8 +714,10 @@ int main(int argc, char* argv[])
   {
     // set default value, if nothing has been set yet
     tableLimit = 600;
-    std::cout << "Info: Table width limit was set to " << tableLimit << " by default.\n";
+    info << "Info: Table width limit was set to " << tableLimit << " by default.\n";
   }
+  if (!checkOnly)
+    std::cout << info.str();
 
   //prepare BB codes
   //image tags
@@ -395,38 +744,41 @@ int main(int argc, char* argv[])
   // hr code
   HorizontalRuleBBCode hr("hr", standard);
 
-  // add it to the parser
-  BBCodeParser parser;
-  parser.addCode(&bbcode_default::b);
-  parser.addCode(&bbcode_default::u);
-  parser.addCode(&bbcode_default::i);
-  parser.addCode(&bbcode_default::s);
-  parser.addCode(&bbcode_default::sup);
-  parser.addCode(&bbcode_default::sub);
-  parser.addCode(&bbcode_default::indent);
-  parser.addCode(&bbcode_default::center);
-  parser.addCode(&bbcode_default::left);
-  parser.addCode(&bbcode_default::right);
+  // add it to the pipeline - each document only gets the codes and
+  // processors that can actually change it
+  Pipeline pipeline;
+  pipeline.addCode("b", &bbcode_default::b);
+  pipeline.addCode("u", &bbcode_default::u);
+  pipeline.addCode("i", &bbcode_default::i);
+  pipeline.addCode("s", &bbcode_default::s);
+  pipeline.addCode("sup", &bbcode_default::sup);
+  pipeline.addCode("sub", &bbcode_default::sub);
+  pipeline.addCode("indent", &bbcode_default::indent);
+  pipeline.addCode("center", &bbcode_default::center);
+  pipeline.addCode("left", &bbcode_default::left);
+  pipeline.addCode("right", &bbcode_default::right);
   if (trimmablePrefix.empty())
   {
-    parser.addCode(&img_simple);
-    parser.addCode(&img_advanced);
-    parser.addCode(&bbcode_default::url_simple);
-    parser.addCode(&bbcode_default::url_advanced);
+    pipeline.addCode("img", &img_simple);
+    pipeline.addCode("img", &img_advanced);
+    pipeline.addCode("url", &bbcode_default::url_simple);
+    pipeline.addCode("url", &bbcode_default::url_advanced);
   }
   else
   {
-    parser.addCode(&img_simple_trim);
-    parser.addCode(&img_advanced_trim);
-    parser.addCode(&url_simple_trim);
-    parser.addCode(&url_advanced_trim);
+    pipeline.addCode("img", &img_simple_trim);
+    pipeline.addCode("img", &img_advanced_trim);
+    pipeline.addCode("url", &url_simple_trim);
+    pipeline.addCode("url", &url_advanced_trim);
   }
-  parser.addCode(&bbcode_default::color);
-  parser.addCode(&bbcode_default::size);
-  parser.addCode(&bbcode_default::font);
-  if (!noList) parser.addCode(&list_unordered);
-  parser.addCode(&table);
-  parser.addCode(&hr);
+  pipeline.addCode("color", &bbcode_default::color);
+  pipeline.addCode("size", &bbcode_default::size);
+  pipeline.addCode("font", &bbcode_default::font);
+  if (!noList) pipeline.addCode("list", &list_unordered);
+  pipeline.addCode("table", &table);
+  pipeline.addInnerTag("tr");
+  pipeline.addInnerTag("td");
+  pipeline.addCode("hr", &hr, Pipeline::TagKind::single);
 
   NormalisingPreProcessor normaliser;
   KillSpacesBeforeNewline eatRedundantSpaces;
@@ -436,95 +788,146 @@ int main(int argc, char* argv[])
   TablePostProcessor table_indent;
   TDR_PostProcessor tdr_post;
 
-  if (nl2br) parser.addPreProcessor(&normaliser);
-  parser.addPreProcessor(&eatRedundantSpaces);
-  if (nl2br && !noList) parser.addPreProcessor(&preProc_List);
-  if (spaceTrim) parser.addPreProcessor(&preProc_Spaces);
-  if (nl2br) parser.addPreProcessor(&table_killLF);
-  parser.addPostProcessor(&table_indent);
-  parser.addPostProcessor(&tdr_post);
+  if (nl2br) pipeline.addPreProcessor(&normaliser,
+      [](const DocumentProfile& p) { return p.hasCarriageReturn; });
+  pipeline.addPreProcessor(&eatRedundantSpaces,
+      [](const DocumentProfile& p) { return p.hasNewline; });
+  if (nl2br && !noList) pipeline.addPreProcessor(&preProc_List,
+      [](const DocumentProfile& p) { return p.hasTag("list"); });
+  if (spaceTrim) pipeline.addPreProcessor(&preProc_Spaces,
+      [](const DocumentProfile& p) { return p.hasDoubleSpace; });
+  if (nl2br) pipeline.addPreProcessor(&table_killLF,
+      [](const DocumentProfile& p) { return p.hasTag("table") || p.hasTag("tr") || p.hasTag("td"); });
+  // The post-processors only change whitespace, see --compact. They look for
+  // HTML tags, which are either generated by the codes or literal input.
+  if (!compact)
+  {
+    pipeline.addPostProcessor(&table_indent,
+        [](const DocumentProfile& p) { return p.hasTag("table") || p.hasLessThan; });
+    pipeline.addPostProcessor(&tdr_post,
+        [](const DocumentProfile& p) { return p.hasTag("center") || p.hasLessThan; });
+  }
+
+  ConversionOptions options;
+  options.standard = standard;
+  options.nl2br = nl2br;
+  #ifndef NO_STRING_CONVERSION
+  options.isUTF8 = isUTF8;
+  #endif
+  options.compression = compression;
+  options.budget = budget.get();
 
-  for (const auto& path: pathTexts)
+  // Files are processed in alphabetical order by default. With a memory
+  // limit the largest files go first, and files that cannot fit into the
+  // limit are rejected before anything is converted. Files that pass here
+  // are not checked again, even if later conversions raise the estimate,
+  // except for compressed files, whose real size is not known yet.
+  std::vector<std::pair<std::string, std::uint64_t> > queue;
+  if (budget)
   {
-    // read file contents
-    std::ifstream input;
-    input.open(path, std::ios_base::in | std::ios_base::binary);
-    if (!input)
+    std::string failed;
+    if (!largestFirst(pathTexts, queue, failed))
     {
-      std::cerr << "Error: Could not open file \"" << path << "\"!\n";
+      std::cerr << "Error: Could not determine size of file \"" << failed << "\"!\n";
       return rcFileError;
     }
-    input.seekg(0, std::ios_base::end);
-    const std::streamsize len = input.tellg();
-    input.seekg(0, std::ios_base::beg);
-    if (!input.good())
+    for (const auto& [path, size]: queue)
     {
-      #ifdef DEBUG
-      std::cerr << "Error while reading file content: seek operation failed!\n";
-      #endif
-      input.close();
-      return rcFileError;
-    }
-    if (len > 1024*1024)
-    {
-      #ifdef DEBUG
-      std::cerr << "Error while reading file content: unexpectedly large file size!\n";
-      #endif
-      input.close();
-      return rcFileError;
-    }
-    // allocate buffer - all file content should fit into it
-    char * buffer = new char[len + 1];
-    memset(buffer, '\0', len + 1); //zerofill buffer
-    input.read(buffer, len);
-    if (!input.good())
-    {
-      delete[] buffer;
-      buffer = nullptr;
-      input.close();
-      std::cerr << "Error while reading file content of \"" << path << "\"!\n";
-      return rcFileError;
+      if (size > maxInputSize)
+      {
+        std::cerr << "Error: File \"" << path << "\" is larger than the maximum "
+                  << "of " << maxInputSize << " bytes!\n";
+        return rcFileError;
+      }
+      if (!budget->admits(size))
+      {
+        std::cerr << "Error: Converting file \"" << path << "\" needs about "
+                  << budget->estimate(size) << " bytes of memory, but the "
+                  << "memory limit is " << budget->limit() << " bytes!\n";
+        return rcMemoryLimit;
+      }
     }
-    input.close();
+  }
+  else
+  {
+    for (const auto& path: pathTexts)
+      queue.emplace_back(path, 0);
+  }
 
-    std::string content(buffer);
-    delete[] buffer;
-    buffer = nullptr;
+  // names of the codes that need a closing tag
+  const std::set<std::string> pairedCodes = pipeline.tagNames(Pipeline::TagKind::paired);
 
-    #ifndef NO_STRING_CONVERSION
-    if (isUTF8)
+  if (checkOnly)
+  {
+    const BBCodeChecker checker(pairedCodes, pipeline.tagNames(Pipeline::TagKind::single));
+    bool allValid = true;
+    for (const auto& entry: queue)
     {
-      // convert content to iso-8859-1
-      std::string iso_content;
-      if (!libstriezel::encoding::utf8_to_iso8859_1(content, iso_content))
+      std::string content;
+      const int rc = readInputFile(entry.first, budget.get(), content);
+      if (rc != 0)
+        return rc;
+      const std::vector<TagIssue> issues = checker.check(content);
+      for (const auto& issue: issues)
       {
-        std::cerr << "Error: Conversion from UTF-8 failed!\n";
-        return rcConversionFail;
+        std::cout << entry.first << ": offset " << issue.offset << ": "
+                  << issue.message << "\n";
       }
-      content = iso_content;
-    } // if UTF-8
-    #endif
+      if (!issues.empty())
+        allValid = false;
+    }
+    return allValid ? 0 : rcCheckFailed;
+  }
 
-    handleSpecialChars(content);
-    content = parser.parse(content, "", standard, nl2br);
+  // The next files are read into the page cache in the background while the
+  // current file is converted, so that conversion and disk I/O overlap.
+  for (std::size_t idx = 0; (idx < prefetchDepth) && (idx < queue.size()); ++idx)
+  {
+    prefetchFile(queue[idx].first);
+  }
+  for (std::size_t idx = 0; idx < queue.size(); ++idx)
+  {
+    if (idx + prefetchDepth < queue.size())
+      prefetchFile(queue[idx + prefetchDepth].first);
+    const int rc = processFile(queue[idx].first, pipeline, options);
+    if (rc != 0)
+      return rc;
+  }
 
-    // save content
-    std::ofstream output;
-    output.open(path + "_htmlified", std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
-    if (!output)
+  #if defined(__linux__)
+  if (!watchDirectoryPath.empty())
+  {
+    // The pipeline stays configured, only changed files are converted again,
+    // and of those only the changed blocks. Errors are reported per file and
+    // do not end the watch.
+    const IncrementalRenderer::Converter convertBlock = [&pipeline, &options](const std::string& text)
     {
-      std::cerr << "Could not open output file " << path << "_htmlified for writing!\n";
-      return rcFileError;
-    }
-    output.write(content.c_str(), content.length());
-    if (!output.good())
+      return convertText(text, pipeline, options);
+    };
+    std::map<std::string, IncrementalRenderer> renderers;
+    const auto convert = [&](const std::string& path)
     {
-      std::cerr << "Error while writing to file \"" << path << "_htmlified\"!\n";
-      output.close();
+      // Each renderer holds a copy of its file's text and output, so the
+      // renderers of files that are gone, e.g. renamed temporary files, are
+      // dropped, as are those of files that could not be converted.
+      for (auto iter = renderers.begin(); iter != renderers.end(); )
+      {
+        if (libstriezel::filesystem::file::exists(iter->first))
+          ++iter;
+        else
+          iter = renderers.erase(iter);
+      }
+      auto iter = renderers.find(path);
+      if (iter == renderers.end())
+        iter = renderers.emplace(path, IncrementalRenderer(convertBlock, pairedCodes)).first;
+      const int rc = processFile(path, pipeline, options, &iter->second);
+      if (rc != 0)
+        renderers.erase(iter);
+      return rc;
+    };
+    if (!watchDirectory(watchDirectoryPath, convert))
       return rcFileError;
-    }
-    output.close();
-    std::cout << "Processed file " << path << "\n";
   }
+  #endif
   return 0;
 }
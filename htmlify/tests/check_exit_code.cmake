@@ -0,0 +1,14 @@
+# Runs htmlify --check on a file and compares the exit code with the expected
+# one, because CTest itself only distinguishes between zero and non-zero.
+#
+# variables:
+#   HTMLIFY            - path of the htmlify executable
+#   INPUT              - the file to check
+#   EXPECTED_EXIT_CODE - the expected exit code
+
+execute_process(COMMAND "${HTMLIFY}" --check "${INPUT}"
+                RESULT_VARIABLE rc
+                OUTPUT_QUIET)
+if (NOT rc EQUAL EXPECTED_EXIT_CODE)
+  message(FATAL_ERROR "htmlify --check exited with ${rc}, expected ${EXPECTED_EXIT_CODE}.")
+endif ()
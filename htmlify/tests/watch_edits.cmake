@@ -0,0 +1,33 @@
+# Helper for watch_matches_batch.cmake: saves the versions incremental_*.txt
+# of a text one after another as the same file in the watched directory,
+# waits for each conversion and keeps a copy of its result. Finally the
+# watched directory is removed.
+#
+# variables:
+#   SOURCE_DIR - directory that contains the versions of the text
+#   WORK_DIR   - directory with the subdirectories watch and results
+
+set(document "${WORK_DIR}/watch/document.txt")
+
+# give htmlify time to set up the watch
+execute_process(COMMAND "${CMAKE_COMMAND}" -E sleep 1)
+
+file(GLOB versions RELATIVE "${SOURCE_DIR}" "${SOURCE_DIR}/incremental_*.txt")
+list(SORT versions)
+foreach (version ${versions})
+  file(REMOVE "${document}_htmlified")
+  configure_file("${SOURCE_DIR}/${version}" "${document}" COPYONLY)
+  foreach (attempt RANGE 30)
+    if (EXISTS "${document}_htmlified")
+      break ()
+    endif ()
+    execute_process(COMMAND "${CMAKE_COMMAND}" -E sleep 1)
+  endforeach ()
+  # the file may still be in the process of being written
+  execute_process(COMMAND "${CMAKE_COMMAND}" -E sleep 1)
+  if (EXISTS "${document}_htmlified")
+    configure_file("${document}_htmlified" "${WORK_DIR}/results/${version}" COPYONLY)
+  endif ()
+endforeach ()
+
+file(REMOVE_RECURSE "${WORK_DIR}/watch")
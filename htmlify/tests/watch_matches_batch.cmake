@@ -0,0 +1,44 @@
+# Converts the versions incremental_*.txt of a text one after another in watch
+# mode, where only the changed blocks are converted again, and compares each
+# result with the conversion of the whole version in batch mode.
+#
+# variables:
+#   HTMLIFY    - path of the htmlify executable
+#   SOURCE_DIR - directory that contains the versions of the text
+#   WORK_DIR   - directory for the generated files, will be deleted first
+#   OPTIONS    - additional command line options for htmlify (optional)
+
+separate_arguments(options UNIX_COMMAND "${OPTIONS}")
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/batch" "${WORK_DIR}/watch" "${WORK_DIR}/results")
+
+file(GLOB versions RELATIVE "${SOURCE_DIR}" "${SOURCE_DIR}/incremental_*.txt")
+list(SORT versions)
+foreach (version ${versions})
+  configure_file("${SOURCE_DIR}/${version}" "${WORK_DIR}/batch/${version}" COPYONLY)
+  execute_process(COMMAND "${HTMLIFY}" ${options} "${WORK_DIR}/batch/${version}"
+                  RESULT_VARIABLE rc OUTPUT_QUIET)
+  if (NOT rc EQUAL 0)
+    message(FATAL_ERROR "Batch conversion of ${version} failed: ${rc}")
+  endif ()
+endforeach ()
+
+# The second process writes the versions into the watched directory and
+# removes that directory at the end, which ends watch mode.
+execute_process(COMMAND "${HTMLIFY}" ${options} --watch "${WORK_DIR}/watch"
+                COMMAND "${CMAKE_COMMAND}" "-DSOURCE_DIR=${SOURCE_DIR}" "-DWORK_DIR=${WORK_DIR}"
+                        -P "${CMAKE_CURRENT_LIST_DIR}/watch_edits.cmake"
+                TIMEOUT 120
+                OUTPUT_QUIET)
+
+foreach (version ${versions})
+  if (NOT EXISTS "${WORK_DIR}/results/${version}")
+    message(FATAL_ERROR "Watch mode did not convert ${version}.")
+  endif ()
+  file(READ "${WORK_DIR}/batch/${version}_htmlified" expected)
+  file(READ "${WORK_DIR}/results/${version}" actual)
+  if (NOT actual STREQUAL expected)
+    message(FATAL_ERROR "Watch mode output for ${version} differs from batch output.\n"
+                        "batch:\n${expected}\nwatch mode:\n${actual}")
+  endif ()
+endforeach ()